@@ -40,6 +40,9 @@ using TableNamesSet = std::unordered_set<QualifiedTableName>;
 /// Puts an element into the map, locks tables's mutex, counts how much threads run parallel query on the table,
 /// when counter is 0 erases element in the destructor.
 /// If the element already exists in the map, waits when ddl query will be finished in other thread.
+/// Additionally holds the database-level SharedMutex in shared mode, so table-level DDL on different
+/// tables of one database runs concurrently, while DROP/RENAME DATABASE takes the same mutex
+/// exclusively (see getExclusiveDDLGuardForDatabase) and excludes all of them at once.
 class DDLGuard
 {
 public:
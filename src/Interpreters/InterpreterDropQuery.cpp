@@ -1,10 +1,10 @@
+#include <algorithm>
 #include <Databases/IDatabase.h>
 #include <Interpreters/Context.h>
 #include <Interpreters/DatabaseCatalog.h>
 #include <Interpreters/executeDDLQueryOnCluster.h>
 #include <Interpreters/InterpreterFactory.h>
 #include <Interpreters/InterpreterDropQuery.h>
-#include <Interpreters/ExternalDictionariesLoader.h>
 #include <Interpreters/QueryLog.h>
 #include <IO/SharedThreadPools.h>
 #include <Access/Common/AccessRightsElement.h>
@@ -12,7 +12,6 @@
 #include <Parsers/ASTIdentifier.h>
 #include <Storages/IStorage.h>
 #include <Storages/MergeTree/MergeTreeData.h>
-#include <Common/escapeForFileName.h>
 #include <Common/quoteString.h>
 #include <Common/typeid_cast.h>
 #include <Core/Settings.h>
@@ -50,11 +49,6 @@ namespace ErrorCodes
     extern const int TABLE_NOT_EMPTY;
 }
 
-namespace ActionLocks
-{
-    extern const StorageActionBlockType PartsMerge;
-}
-
 static DatabasePtr tryGetDatabase(const String & database_name, bool if_exists)
 {
     return if_exists ? DatabaseCatalog::instance().tryGetDatabase(database_name) : DatabaseCatalog::instance().getDatabase(database_name);
@@ -128,7 +122,9 @@ BlockIO InterpreterDropQuery::executeToTable(ASTDropQuery & query)
 
 BlockIO InterpreterDropQuery::executeToTableImpl(const ContextPtr & context_, ASTDropQuery & query, DatabasePtr & db, UUID & uuid_to_wait)
 {
-    /// NOTE: it does not contain UUID, we will resolve it with locked DDLGuard
+    /// NOTE: for a single-table query this does not contain the UUID, it is resolved later with
+    /// the DDLGuard locked; the per-table queries of DROP DATABASE carry the UUID collected from
+    /// the tables iterator, and for them the resolution is skipped.
     auto table_id = StorageID(query);
     if (query.temporary || table_id.database_name.empty())
     {
@@ -145,15 +141,28 @@ BlockIO InterpreterDropQuery::executeToTableImpl(const ContextPtr & context_, AS
         throw Exception(ErrorCodes::UNKNOWN_TABLE, "Temporary table {} doesn't exist", backQuoteIfNeed(table_id.table_name));
     }
 
+    /// The guard must be taken even for queries applied from the replicated DDL log: the applier
+    /// serializes log entries, but e.g. SYSTEM RESTART REPLICA detaches and re-attaches the table
+    /// on a user thread under the same guard, and must not interleave with a log-applied DROP.
     auto ddl_guard = (!query.no_ddl_lock ? DatabaseCatalog::instance().getDDLGuard(table_id.database_name, table_id.table_name) : nullptr);
 
+    DatabaseAndTable database_and_table;
+    /// DROP DATABASE passes the already resolved database in `db`, so we don't look it up by name for every table.
     /// If table was already dropped by anyone, an exception will be thrown
-    auto [database, table] = query.if_exists ? DatabaseCatalog::instance().tryGetDatabaseAndTable(table_id, context_)
-                                             : DatabaseCatalog::instance().getDatabaseAndTable(table_id, context_);
+    if (db)
+        database_and_table = {db, db->tryGetTable(table_id.table_name, context_)};
+    else if (query.if_exists)
+        database_and_table = DatabaseCatalog::instance().tryGetDatabaseAndTable(table_id, context_);
+    else
+        database_and_table = DatabaseCatalog::instance().getDatabaseAndTable(table_id, context_);
+    auto & [database, table] = database_and_table;
 
     if (database && table)
     {
-        const auto & settings = getContext()->getSettingsRef();
+        const auto & settings = context_->getSettingsRef();
+        /// getCurrentQueryId() returns the id by value; bind the underlying field instead,
+        /// lockExclusively only needs a const reference.
+        const String & current_query_id = context_->getClientInfo().current_query_id;
         if (query.if_empty)
         {
             if (auto rows = table->totalRows(settings); rows > 0)
@@ -161,22 +170,20 @@ BlockIO InterpreterDropQuery::executeToTableImpl(const ContextPtr & context_, AS
         }
         checkStorageSupportsTransactionsIfNeeded(table, context_);
 
-        auto & ast_drop_query = query.as<ASTDropQuery &>();
-
-        if (ast_drop_query.is_view && !table->isView())
+        if (query.is_view && !table->isView())
             throw Exception(ErrorCodes::INCORRECT_QUERY,
                 "Table {} is not a View",
                 table_id.getNameForLogs());
 
-        if (ast_drop_query.is_dictionary && !table->isDictionary())
+        if (query.is_dictionary && !table->isDictionary())
             throw Exception(ErrorCodes::INCORRECT_QUERY,
                 "Table {} is not a Dictionary",
                 table_id.getNameForLogs());
 
-        if (settings[Setting::ignore_drop_queries_probability] != 0 && ast_drop_query.kind == ASTDropQuery::Kind::Drop
+        if (settings[Setting::ignore_drop_queries_probability] != 0 && query.kind == ASTDropQuery::Kind::Drop
             && std::uniform_real_distribution<>(0.0, 1.0)(thread_local_rng) <= settings[Setting::ignore_drop_queries_probability])
         {
-            ast_drop_query.sync = false;
+            query.sync = false;
             if (table->storesDataOnDisk())
             {
                 LOG_TEST(getLogger("InterpreterDropQuery"), "Ignore DROP TABLE query for table {}.{}", table_id.database_name, table_id.table_name);
@@ -184,142 +191,171 @@ BlockIO InterpreterDropQuery::executeToTableImpl(const ContextPtr & context_, AS
             }
 
             LOG_TEST(getLogger("InterpreterDropQuery"), "Replace DROP TABLE query to TRUNCATE TABLE for table {}.{}", table_id.database_name, table_id.table_name);
-            ast_drop_query.kind = ASTDropQuery::Truncate;
+            query.kind = ASTDropQuery::Truncate;
         }
 
-        /// Now get UUID, so we can wait for table data to be finally dropped
-        table_id.uuid = database->tryGetTableUUID(table_id.table_name);
+        /// Now get UUID (unless the query already carries it), so we can wait for table data to be finally dropped
+        if (table_id.uuid == UUIDHelpers::Nil)
+            table_id.uuid = database->tryGetTableUUID(table_id.table_name);
 
         /// Prevents recursive drop from drop database query. The original query must specify a table.
         bool is_drop_or_detach_database = !current_query_ptr->as<ASTDropQuery>()->table;
 
-        AccessFlags drop_storage;
+        /// Ordinary (no-UUID) databases need an exclusive table lock for DETACH/DROP and an mmap cache
+        /// drop afterwards; evaluate the virtual call once instead of in every branch.
+        bool is_database_without_uuid = database->getUUID() == UUIDHelpers::Nil;
 
-        if (table->isView())
-            drop_storage = AccessType::DROP_VIEW;
-        else if (table->isDictionary())
-            drop_storage = AccessType::DROP_DICTIONARY;
-        else
-            drop_storage = AccessType::DROP_TABLE;
+        const AccessFlags drop_storage = table->isView() ? AccessType::DROP_VIEW
+            : table->isDictionary()                      ? AccessType::DROP_DICTIONARY
+                                                         : AccessType::DROP_TABLE;
 
-        auto new_query_ptr = query.clone();
-        auto & query_to_send = new_query_ptr->as<ASTDropQuery &>();
+        /// The query is cloned lazily: only the ON CLUSTER and replicated paths below need a copy
+        /// to send, and the common local path (every per-table drop of DROP DATABASE in particular)
+        /// should not pay for a per-call AST subtree allocation.
+        ASTPtr new_query_ptr;
 
-        if (!query.cluster.empty() && !maybeRemoveOnCluster(new_query_ptr, getContext()))
+        if (!query.cluster.empty())
         {
-            query_to_send.if_empty = false;
+            new_query_ptr = query.clone();
+            if (!maybeRemoveOnCluster(new_query_ptr, getContext()))
+            {
+                new_query_ptr->as<ASTDropQuery &>().if_empty = false;
 
-            DDLQueryOnClusterParams params;
-            params.access_to_check = getRequiredAccessForDDLOnCluster();
-            return executeDDLQueryOnCluster(new_query_ptr, getContext(), params);
+                DDLQueryOnClusterParams params;
+                params.access_to_check = getRequiredAccessForDDLOnCluster();
+                return executeDDLQueryOnCluster(new_query_ptr, getContext(), params);
+            }
         }
 
         if (database->shouldReplicateQuery(getContext(), current_query_ptr))
         {
-            if (query.kind == ASTDropQuery::Kind::Detach)
-                context_->checkAccess(drop_storage, table_id);
-            else if (query.kind == ASTDropQuery::Kind::Truncate)
-                context_->checkAccess(AccessType::TRUNCATE, table_id);
-            else if (query.kind == ASTDropQuery::Kind::Drop)
-                context_->checkAccess(drop_storage, table_id);
+            switch (query.kind)
+            {
+                case ASTDropQuery::Kind::Detach:
+                case ASTDropQuery::Kind::Drop:
+                    context_->checkAccess(drop_storage, table_id);
+                    break;
+                case ASTDropQuery::Kind::Truncate:
+                    context_->checkAccess(AccessType::TRUNCATE, table_id);
+                    break;
+            }
 
-            ddl_guard->releaseTableLock();
+            if (ddl_guard)
+                ddl_guard->releaseTableLock();
             table.reset();
 
-            query_to_send.if_empty = false;
+            /// Reuse the clone made for ON CLUSTER rewriting if there was one.
+            if (!new_query_ptr)
+                new_query_ptr = query.clone();
+            new_query_ptr->as<ASTDropQuery &>().if_empty = false;
 
             return database->tryEnqueueReplicatedDDL(new_query_ptr, context_);
         }
 
-        if (query.kind == ASTDropQuery::Kind::Detach)
+        switch (query.kind)
         {
-            context_->checkAccess(drop_storage, table_id);
-
-            if (table->isDictionary())
+            case ASTDropQuery::Kind::Detach:
             {
-                /// If DROP DICTIONARY query is not used, check if Dictionary can be dropped with DROP TABLE query
-                if (!query.is_dictionary)
-                    table->checkTableCanBeDetached();
-            }
-            else
-                table->checkTableCanBeDetached();
-
-            table->flushAndShutdown();
-            TableExclusiveLockHolder table_lock;
+                context_->checkAccess(drop_storage, table_id);
 
-            if (database->getUUID() == UUIDHelpers::Nil)
-                table_lock = table->lockExclusively(context_->getCurrentQueryId(), context_->getSettingsRef()[Setting::lock_acquire_timeout]);
+                if (table->isDictionary())
+                {
+                    /// If DROP DICTIONARY query is not used, check if Dictionary can be dropped with DROP TABLE query
+                    if (!query.is_dictionary)
+                        table->checkTableCanBeDetached();
+                }
+                else
+                    table->checkTableCanBeDetached();
 
-            if (query.permanently)
-            {
-                /// Server may fail to restart of DETACH PERMANENTLY if table has dependent ones
-                bool check_ref_deps = getContext()->getSettingsRef()[Setting::check_referential_table_dependencies];
-                bool check_loading_deps = !check_ref_deps && getContext()->getSettingsRef()[Setting::check_table_dependencies];
-                DatabaseCatalog::instance().removeDependencies(table_id, check_ref_deps, check_loading_deps, is_drop_or_detach_database);
-                /// Drop table from memory, don't touch data, metadata file renamed and will be skipped during server restart
-                database->detachTablePermanently(context_, table_id.table_name);
+                table->flushAndShutdown();
+                TableExclusiveLockHolder table_lock;
+
+                if (is_database_without_uuid)
+                    table_lock = table->lockExclusively(current_query_id, settings[Setting::lock_acquire_timeout]);
+
+                if (query.permanently)
+                {
+                    /// Server may fail to restart of DETACH PERMANENTLY if table has dependent ones
+                    bool check_ref_deps = settings[Setting::check_referential_table_dependencies];
+                    bool check_loading_deps = !check_ref_deps && settings[Setting::check_table_dependencies];
+                    DatabaseCatalog::instance().removeDependencies(table_id, check_ref_deps, check_loading_deps, is_drop_or_detach_database);
+                    /// Drop table from memory, don't touch data, metadata file renamed and will be skipped during server restart
+                    database->detachTablePermanently(context_, table_id.table_name);
+                }
+                else
+                {
+                    /// Drop table from memory, don't touch data and metadata
+                    database->detachTable(context_, table_id.table_name);
+                }
+                break;
             }
-            else
+            case ASTDropQuery::Kind::Truncate:
             {
-                /// Drop table from memory, don't touch data and metadata
-                database->detachTable(context_, table_id.table_name);
-            }
-        }
-        else if (query.kind == ASTDropQuery::Kind::Truncate)
-        {
-            if (table->isDictionary())
-                throw Exception(ErrorCodes::SYNTAX_ERROR, "Cannot TRUNCATE dictionary");
-
-            context_->checkAccess(AccessType::TRUNCATE, table_id);
-            if (table->isStaticStorage())
-                throw Exception(ErrorCodes::TABLE_IS_READ_ONLY, "Table is read-only");
-
-            table->checkTableCanBeDropped(context_);
+                if (table->isDictionary())
+                    throw Exception(ErrorCodes::SYNTAX_ERROR, "Cannot TRUNCATE dictionary");
 
-            TableExclusiveLockHolder table_excl_lock;
-            /// We don't need any lock for ReplicatedMergeTree and for simple MergeTree
-            /// For the rest of tables types exclusive lock is needed
-            if (!std::dynamic_pointer_cast<MergeTreeData>(table))
-                table_excl_lock = table->lockExclusively(context_->getCurrentQueryId(), context_->getSettingsRef()[Setting::lock_acquire_timeout]);
-
-            auto metadata_snapshot = table->getInMemoryMetadataPtr();
-            /// Drop table data, don't touch metadata
-            table->truncate(current_query_ptr, metadata_snapshot, context_, table_excl_lock);
-        }
-        else if (query.kind == ASTDropQuery::Kind::Drop)
-        {
-            context_->checkAccess(drop_storage, table_id);
+                context_->checkAccess(AccessType::TRUNCATE, table_id);
+                if (table->isStaticStorage())
+                    throw Exception(ErrorCodes::TABLE_IS_READ_ONLY, "Table is read-only");
 
-            if (table->isDictionary())
-            {
-                /// If DROP DICTIONARY query is not used, check if Dictionary can be dropped with DROP TABLE query
-                if (!query.is_dictionary)
+                /// For DROP/TRUNCATE DATABASE the check has already been done for all tables
+                /// at once in the parallel preparation pass of executeToDatabaseImpl.
+                if (!is_drop_or_detach_database)
                     table->checkTableCanBeDropped(context_);
-            }
-            else
-                table->checkTableCanBeDropped(context_);
 
-            /// Check dependencies before shutting table down
-            bool check_ref_deps = getContext()->getSettingsRef()[Setting::check_referential_table_dependencies];
-            bool check_loading_deps = !check_ref_deps && getContext()->getSettingsRef()[Setting::check_table_dependencies];
-            DatabaseCatalog::instance().checkTableCanBeRemovedOrRenamed(table_id, check_ref_deps, check_loading_deps, is_drop_or_detach_database);
+                TableExclusiveLockHolder table_excl_lock;
+                /// We don't need any lock for ReplicatedMergeTree and for simple MergeTree
+                /// For the rest of tables types exclusive lock is needed
+                if (!std::dynamic_pointer_cast<MergeTreeData>(table))
+                    table_excl_lock = table->lockExclusively(current_query_id, settings[Setting::lock_acquire_timeout]);
 
-            table->flushAndShutdown(true);
+                auto metadata_snapshot = table->getInMemoryMetadataPtr();
+                /// Drop table data, don't touch metadata
+                table->truncate(current_query_ptr, metadata_snapshot, context_, table_excl_lock);
+                break;
+            }
+            case ASTDropQuery::Kind::Drop:
+            {
+                context_->checkAccess(drop_storage, table_id);
 
-            TableExclusiveLockHolder table_lock;
-            if (database->getUUID() == UUIDHelpers::Nil)
-                table_lock = table->lockExclusively(context_->getCurrentQueryId(), context_->getSettingsRef()[Setting::lock_acquire_timeout]);
+                /// For DROP DATABASE the check has already been done for all tables at once
+                /// in the parallel preparation pass of executeToDatabaseImpl.
+                if (!is_drop_or_detach_database)
+                {
+                    if (table->isDictionary())
+                    {
+                        /// If DROP DICTIONARY query is not used, check if Dictionary can be dropped with DROP TABLE query
+                        if (!query.is_dictionary)
+                            table->checkTableCanBeDropped(context_);
+                    }
+                    else
+                        table->checkTableCanBeDropped(context_);
+                }
+
+                /// Check dependencies before shutting table down
+                bool check_ref_deps = settings[Setting::check_referential_table_dependencies];
+                bool check_loading_deps = !check_ref_deps && settings[Setting::check_table_dependencies];
+                DatabaseCatalog::instance().checkTableCanBeRemovedOrRenamed(table_id, check_ref_deps, check_loading_deps, is_drop_or_detach_database);
+
+                table->flushAndShutdown(true);
+
+                TableExclusiveLockHolder table_lock;
+                if (is_database_without_uuid)
+                    table_lock = table->lockExclusively(current_query_id, settings[Setting::lock_acquire_timeout]);
 
-            DatabaseCatalog::instance().removeDependencies(table_id, check_ref_deps, check_loading_deps, is_drop_or_detach_database);
-            database->dropTable(context_, table_id.table_name, query.sync);
+                DatabaseCatalog::instance().removeDependencies(table_id, check_ref_deps, check_loading_deps, is_drop_or_detach_database);
+                database->dropTable(context_, table_id.table_name, query.sync);
 
-            /// We have to clear mmapio cache when dropping table from Ordinary database
-            /// to avoid reading old data if new table with the same name is created
-            if (database->getUUID() == UUIDHelpers::Nil)
-                context_->clearMMappedFileCache();
+                /// We have to clear mmapio cache when dropping table from Ordinary database
+                /// to avoid reading old data if new table with the same name is created
+                if (is_database_without_uuid)
+                    context_->clearMMappedFileCache();
+                break;
+            }
         }
 
-        db = database;
+        if (!db)
+            db = database;
         uuid_to_wait = table_id.uuid;
     }
 
@@ -340,7 +376,7 @@ BlockIO InterpreterDropQuery::executeToTemporaryTable(const String & table_name,
             if (kind == ASTDropQuery::Kind::Truncate)
             {
                 auto table_lock
-                    = table->lockExclusively(getContext()->getCurrentQueryId(), getContext()->getSettingsRef()[Setting::lock_acquire_timeout]);
+                    = table->lockExclusively(getContext()->getClientInfo().current_query_id, getContext()->getSettingsRef()[Setting::lock_acquire_timeout]);
                 /// Drop table data, don't touch metadata
                 auto metadata_snapshot = table->getInMemoryMetadataPtr();
                 table->truncate(current_query_ptr, metadata_snapshot, getContext(), table_lock);
@@ -434,35 +470,96 @@ BlockIO InterpreterDropQuery::executeToDatabaseImpl(const ASTDropQuery & query,
         /// see DatabaseMaterializedMySQL::getTablesIterator()
         auto table_context = Context::createCopy(getContext());
         table_context->setInternalQuery(true);
-        /// Do not hold extra shared pointers to tables
+        /// Do not hold extra shared pointers to tables: the snapshot below is released as soon as
+        /// the preparation passes are finished.
         std::vector<std::pair<StorageID, bool>> tables_to_drop;
+        std::vector<StoragePtr> table_ptrs;
+
+        bool check_tables_can_be_dropped = query_for_table.kind != ASTDropQuery::Kind::Detach;
+        ThreadPoolCallbackRunnerLocal<void> runner(getDatabaseCatalogDropTablesThreadPool().get(), "DropTables");
         // NOTE: This means we wait for all tables to be loaded inside getTablesIterator() call in case of `async_load_databases = true`.
         for (auto iterator = database->getTablesIterator(table_context); iterator->isValid(); iterator->next())
         {
             auto table_ptr = iterator->table();
             tables_to_drop.push_back({table_ptr->getStorageID(), table_ptr->isDictionary()});
+            table_ptrs.push_back(std::move(table_ptr));
         }
 
-        /// Prepare tables for shutdown in parallel.
-        ThreadPoolCallbackRunnerLocal<void> runner(getDatabaseCatalogDropTablesThreadPool().get(), "DropTables");
-        for (const auto & [name, _] : tables_to_drop)
+        /// Validate droppability of all tables before anything else: the checks must complete
+        /// before the first shutdown task is scheduled, otherwise a failing check would leave the
+        /// already-prepared tables behind with their background work stopped. This way the whole
+        /// DROP DATABASE fails before any table is shut down.
+        if (check_tables_can_be_dropped)
+        {
+            for (const auto & table_ptr : table_ptrs)
+            {
+                /// Dictionaries dropped with the database are not checked, as in executeToTableImpl.
+                if (table_ptr->isDictionary())
+                    continue;
+                runner([my_table_ptr = table_ptr, my_context = table_context]()
+                {
+                    my_table_ptr->checkTableCanBeDropped(my_context);
+                });
+            }
+            runner.waitForAllToFinishAndRethrowFirstError();
+        }
+
+        /// Prepare tables for shutdown in parallel, reusing the StoragePtr from the iterator
+        /// instead of resolving every table by name through the catalog again.
+        for (auto & table_ptr : table_ptrs)
         {
-            auto table_ptr = DatabaseCatalog::instance().getTable(name, table_context);
             runner([my_table_ptr = std::move(table_ptr)]()
             {
                 my_table_ptr->flushAndPrepareForShutdown();
             });
         }
         runner.waitForAllToFinishAndRethrowFirstError();
-
-        for (const auto & table : tables_to_drop)
+        table_ptrs.clear();
+
+        /// Issue dictionary drops first, as it was done when dictionaries had a separate loop.
+        /// This only orders submission: in the parallel branch below dictionary and table drops
+        /// still execute concurrently, so it is best-effort, not a guarantee (nothing relies on
+        /// the ordering for correctness); the sequential Replicated fallback honors it fully.
+        std::stable_partition(tables_to_drop.begin(), tables_to_drop.end(), [](const auto & elem) { return elem.second; });
+
+        /// Drop tables in parallel: they are independent at this point, and most of the time
+        /// is spent in per-table shutdown and metadata IO. Replicated databases propose queries
+        /// through the DDL log, which must stay serial, so fall back to the sequential loop for them.
+        if (typeid_cast<DatabaseReplicated *>(database.get()))
+        {
+            DatabasePtr db = database;
+            for (const auto & table : tables_to_drop)
+            {
+                query_for_table.setTable(table.first.getTableName());
+                query_for_table.uuid = table.first.uuid;
+                query_for_table.is_dictionary = table.second;
+                UUID table_to_wait = UUIDHelpers::Nil;
+                executeToTableImpl(table_context, query_for_table, db, table_to_wait);
+                if (table_to_wait != UUIDHelpers::Nil)
+                    uuids_to_wait.push_back(table_to_wait);
+            }
+        }
+        else
         {
-            query_for_table.setTable(table.first.getTableName());
-            query_for_table.is_dictionary = table.second;
-            DatabasePtr db;
-            UUID table_to_wait = UUIDHelpers::Nil;
-            executeToTableImpl(table_context, query_for_table, db, table_to_wait);
-            uuids_to_wait.push_back(table_to_wait);
+            uuids_to_wait.resize(tables_to_drop.size(), UUIDHelpers::Nil);
+            for (size_t i = 0; i < tables_to_drop.size(); ++i)
+            {
+                runner([&, i, query_ptr_for_table = query_for_table.clone()]()
+                {
+                    auto & query_for_one_table = query_ptr_for_table->as<ASTDropQuery &>();
+                    query_for_one_table.setTable(tables_to_drop[i].first.getTableName());
+                    query_for_one_table.uuid = tables_to_drop[i].first.uuid;
+                    query_for_one_table.is_dictionary = tables_to_drop[i].second;
+                    DatabasePtr db = database;
+                    UUID table_to_wait = UUIDHelpers::Nil;
+                    executeToTableImpl(table_context, query_for_one_table, db, table_to_wait);
+                    uuids_to_wait[i] = table_to_wait;
+                });
+            }
+            runner.waitForAllToFinishAndRethrowFirstError();
+            /// All drops are issued at this point, the waits below only have to collect the completions,
+            /// so tables with nothing to wait for are filtered out right away.
+            std::erase(uuids_to_wait, UUIDHelpers::Nil);
         }
     }
     // only if operation is DETACH
@@ -508,8 +605,8 @@ void InterpreterDropQuery::extendQueryLogElemImpl(DB::QueryLogElement & elem, co
             {
                 auto quoted_database = query_database.empty() ? backQuoteIfNeed(context_->getCurrentDatabase())
                                                               : backQuoteIfNeed(query_database);
-                elem.query_databases.insert(quoted_database);
-                elem.query_tables.insert(quoted_database + "." + backQuoteIfNeed(query_table));
+                elem.query_tables.insert(fmt::format("{}.{}", quoted_database, backQuoteIfNeed(query_table)));
+                elem.query_databases.insert(std::move(quoted_database));
             }
         }
     }
@@ -520,18 +617,17 @@ AccessRightsElements InterpreterDropQuery::getRequiredAccessForDDLOnCluster() co
     AccessRightsElements required_access;
     const auto & drop = current_query_ptr->as<const ASTDropQuery &>();
 
+    /// At most one element is added below.
+    required_access.reserve(1);
+
     if (!drop.table)
     {
-        if (drop.kind == ASTDropQuery::Kind::Detach)
-            required_access.emplace_back(AccessType::DROP_DATABASE, drop.getDatabase());
-        else if (drop.kind == ASTDropQuery::Kind::Drop)
+        if (drop.kind == ASTDropQuery::Kind::Detach || drop.kind == ASTDropQuery::Kind::Drop)
             required_access.emplace_back(AccessType::DROP_DATABASE, drop.getDatabase());
     }
     else if (drop.is_dictionary)
     {
-        if (drop.kind == ASTDropQuery::Kind::Detach)
-            required_access.emplace_back(AccessType::DROP_DICTIONARY, drop.getDatabase(), drop.getTable());
-        else if (drop.kind == ASTDropQuery::Kind::Drop)
+        if (drop.kind == ASTDropQuery::Kind::Detach || drop.kind == ASTDropQuery::Kind::Drop)
             required_access.emplace_back(AccessType::DROP_DICTIONARY, drop.getDatabase(), drop.getTable());
     }
     else if (!drop.temporary)
@@ -0,0 +1,58 @@
+#!/usr/bin/env bash
+# Tags: no-parallel
+# Tag no-parallel: creates databases
+
+CURDIR=$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)
+# shellcheck source=../shell_config.sh
+. "$CURDIR"/../shell_config.sh
+
+db="${CLICKHOUSE_DATABASE}_03245"
+
+$CLICKHOUSE_CLIENT -q "DROP DATABASE IF EXISTS $db SYNC"
+$CLICKHOUSE_CLIENT -q "CREATE DATABASE $db ENGINE = Atomic"
+
+# Enough tables (and a dictionary) for the per-table drops to be spread over the drop-tables thread pool.
+for i in $(seq 1 50)
+do
+    echo "CREATE TABLE $db.t_$i (n UInt64) ENGINE = MergeTree ORDER BY n;"
+    echo "INSERT INTO $db.t_$i VALUES ($i);"
+done | $CLICKHOUSE_CLIENT -n
+$CLICKHOUSE_CLIENT -n -q "
+    CREATE DICTIONARY $db.dict (n UInt64) PRIMARY KEY n
+    SOURCE(CLICKHOUSE(TABLE 't_1' DATABASE '$db'))
+    LAYOUT(FLAT()) LIFETIME(0);
+"
+
+$CLICKHOUSE_CLIENT -q "DROP DATABASE $db SYNC"
+$CLICKHOUSE_CLIENT -q "SELECT count() FROM system.databases WHERE name = '$db'"
+$CLICKHOUSE_CLIENT -q "SELECT count() FROM system.tables WHERE database = '$db'"
+
+# Stress variant: keep creating and dropping tables in the database while it is being dropped.
+# The racing workers may legitimately fail once the database is gone, and the drop itself may
+# lose the race to a concurrent CREATE, so both are retried/ignored; only the end state matters.
+$CLICKHOUSE_CLIENT -q "CREATE DATABASE $db ENGINE = Atomic"
+for i in $(seq 1 20)
+do
+    echo "CREATE TABLE $db.t_$i (n UInt64) ENGINE = MergeTree ORDER BY n;"
+    echo "INSERT INTO $db.t_$i VALUES ($i);"
+done | $CLICKHOUSE_CLIENT -n
+
+function ddl_worker()
+{
+    for i in $(seq 1 30)
+    do
+        $CLICKHOUSE_CLIENT -q "CREATE TABLE $db.extra_${1}_$i (n UInt64) ENGINE = MergeTree ORDER BY n" 2>/dev/null
+        $CLICKHOUSE_CLIENT -q "DROP TABLE IF EXISTS $db.extra_${1}_$i" 2>/dev/null
+    done
+}
+
+ddl_worker 1 &
+ddl_worker 2 &
+
+while ! $CLICKHOUSE_CLIENT -q "DROP DATABASE IF EXISTS $db SYNC" 2>/dev/null
+do
+    sleep 0.3
+done
+wait
+
+$CLICKHOUSE_CLIENT -q "SELECT count() FROM system.databases WHERE name = '$db'"
@@ -0,0 +1,23 @@
+-- Tags: no-parallel
+-- Tag no-parallel: creates a database
+
+DROP DATABASE IF EXISTS db_03246 SYNC;
+CREATE DATABASE db_03246 ENGINE = Atomic;
+
+CREATE TABLE db_03246.small (n UInt64) ENGINE = MergeTree ORDER BY n;
+INSERT INTO db_03246.small VALUES (1);
+CREATE TABLE db_03246.big (n UInt64) ENGINE = MergeTree ORDER BY n;
+INSERT INTO db_03246.big SELECT number FROM numbers(100000);
+
+SET max_table_size_to_drop = 1;
+DROP DATABASE db_03246 SYNC; -- { serverError TABLE_SIZE_EXCEEDS_MAX_DROP_SIZE_LIMIT }
+
+-- The droppability checks run before anything is shut down, so the failed drop
+-- must leave every table in place and fully functional.
+SELECT count() FROM db_03246.small;
+SELECT count() FROM db_03246.big;
+INSERT INTO db_03246.small VALUES (2);
+SELECT count() FROM db_03246.small;
+
+SET max_table_size_to_drop = 0;
+DROP DATABASE db_03246 SYNC;